@@ -3,11 +3,24 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#ifdef NARROW_TYPES
+#include <stdint.h>
+#endif
 
 #define MAX_LINE 3000  // Maximum length of a line in the edgelist
 #define MAX_NAME 1000  // Maximum length of a node name
 #define BUFFER_SIZE 1000000  // Adjust based on expected length of all printed node names comma separated
 bool directed = false;
+// Narrow build only: per-step check that igraph's 64-bit betweenness picks the same edge on the
+// current graph state. Stops at the first mismatch, since later steps would follow the narrow pick.
+bool verify = false;
+
+#ifdef NARROW_TYPES
+// Narrow build: 32-bit vertex/edge IDs in the betweenness kernel, which only keeps totals for the
+// edges incident to the maximum degree node. Path counts and dependencies stay double and follow
+// igraph's arithmetic, since the exact comparison in the edge selection must see the same values.
+typedef int32_t narrow_int_t;
+#endif
 
 
 // Structure to hold clustering results
@@ -184,7 +197,8 @@ void assign_edge_names(igraph_t *graph) {
     }
 }
 
-void delete_edge_by_name(igraph_t *graph, const char *edge_name) {
+// Returns the ID the deleted edge had, or -1 if no edge has that name
+igraph_integer_t delete_edge_by_name(igraph_t *graph, const char *edge_name) {
     igraph_integer_t eid;
     //igraph_es_t es;
     
@@ -195,11 +209,12 @@ void delete_edge_by_name(igraph_t *graph, const char *edge_name) {
             // Found the edge, delete it
             igraph_delete_edges(graph, igraph_ess_1(eid));
             //printf("Pruned edge: %s\n", edge_name);
-            return; // Exit after deletion
+            return eid; // Exit after deletion
         }
     }
 
     printf("Edge not found: %s\n", edge_name);
+    return -1;
 }
 
 void bridges_to_string(const igraph_vector_int_t *bridges, char *bridge_list, size_t buffer_size) {
@@ -268,9 +283,296 @@ void remove_duplicates(igraph_vector_int_t *vec) {
     igraph_vector_int_destroy(&temp);
 }
 
+#ifdef NARROW_TYPES
+// Compressed adjacency of the working graph using 32-bit IDs, plus the betweenness working
+// buffers. Everything is sized once for the full graph and reused while edges are removed.
+typedef struct {
+    narrow_int_t n_nodes;
+    narrow_int_t n_edges;
+    bool directed;              // Out-edges only when true, both directions otherwise
+    narrow_int_t *out_offsets;  // n_nodes + 1 row offsets into out_nbrs/out_eids
+    narrow_int_t *out_nbrs;     // Neighbour of each entry, rows sorted like igraph's incidence lists
+    narrow_int_t *out_eids;     // Edge ID of each entry
+    narrow_int_t *in_offsets;   // Reverse adjacency for the backward pass, same arrays as out_* when undirected
+    narrow_int_t *in_nbrs;
+    narrow_int_t *in_eids;
+
+    narrow_int_t *dist;         // BFS distance from the current source, -1 if unreached
+    narrow_int_t *queue;        // BFS order, walked backwards as igraph pops its stack
+    double *sigma;              // Shortest path counts
+    double *delta;              // Per-source dependencies
+    narrow_int_t *cand_slot;    // Index into cand_sum, -1 if not a candidate
+    double *cand_sum;           // Candidate edge betweenness totals
+    narrow_int_t cand_capacity; // Allocated length of cand_sum, grown to the largest incident list seen
+} NarrowGraph;
+
+// Fill a CSR from entries given in edge ID order. Two stable counting sorts leave each row sorted
+// by neighbour and then edge ID, which is the order of igraph's incidence lists.
+void fill_narrow_csr(narrow_int_t n_nodes, narrow_int_t n_entries, const narrow_int_t *rows, const narrow_int_t *cols,
+                     const narrow_int_t *eids, narrow_int_t *offsets, narrow_int_t *nbrs, narrow_int_t *entry_eids) {
+    narrow_int_t *by_col = malloc((n_entries + 1) * sizeof(narrow_int_t));
+    narrow_int_t *cursor = calloc(n_nodes + 1, sizeof(narrow_int_t));
+    if (!by_col || !cursor) {
+        fprintf(stderr, "Failed to allocate narrow adjacency\n");
+        exit(1);
+    }
+
+    // Order entries by neighbour
+    for (narrow_int_t k = 0; k < n_entries; k++) {
+        cursor[cols[k] + 1]++;
+    }
+    for (narrow_int_t v = 0; v < n_nodes; v++) {
+        cursor[v + 1] += cursor[v];
+    }
+    for (narrow_int_t k = 0; k < n_entries; k++) {
+        by_col[cursor[cols[k]]++] = k;
+    }
+
+    // Place them into rows in that order
+    memset(offsets, 0, (n_nodes + 1) * sizeof(narrow_int_t));
+    for (narrow_int_t k = 0; k < n_entries; k++) {
+        offsets[rows[k] + 1]++;
+    }
+    for (narrow_int_t v = 0; v < n_nodes; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    memcpy(cursor, offsets, (n_nodes + 1) * sizeof(narrow_int_t));
+    for (narrow_int_t j = 0; j < n_entries; j++) {
+        narrow_int_t k = by_col[j];
+        narrow_int_t pos = cursor[rows[k]]++;
+        nbrs[pos] = cols[k];
+        entry_eids[pos] = eids[k];
+    }
+
+    free(by_col);
+    free(cursor);
+}
+
+// Build 32-bit adjacency from an igraph graph, self-loops are never on a shortest path so are skipped
+void init_narrow_graph(const igraph_t *graph, NarrowGraph *ng, bool directed) {
+    igraph_integer_t n_nodes = igraph_vcount(graph);
+    igraph_integer_t n_edges = igraph_ecount(graph);
+
+    if (n_nodes > INT32_MAX || 2 * n_edges > INT32_MAX) {
+        fprintf(stderr, "Graph too large for narrow build, use the 64-bit build\n");
+        exit(1);
+    }
+
+    ng->n_nodes = (narrow_int_t)n_nodes;
+    ng->n_edges = (narrow_int_t)n_edges;
+    ng->directed = directed && igraph_is_directed(graph);
+
+    narrow_int_t n_entries = 0;
+    narrow_int_t *rows = malloc((2 * n_edges + 1) * sizeof(narrow_int_t));
+    narrow_int_t *cols = malloc((2 * n_edges + 1) * sizeof(narrow_int_t));
+    narrow_int_t *eids = malloc((2 * n_edges + 1) * sizeof(narrow_int_t));
+    ng->out_offsets = malloc((n_nodes + 1) * sizeof(narrow_int_t));
+    ng->out_nbrs = malloc((2 * n_edges + 1) * sizeof(narrow_int_t));
+    ng->out_eids = malloc((2 * n_edges + 1) * sizeof(narrow_int_t));
+    ng->dist = malloc((n_nodes + 1) * sizeof(narrow_int_t));
+    ng->queue = malloc((n_nodes + 1) * sizeof(narrow_int_t));
+    ng->sigma = malloc((n_nodes + 1) * sizeof(double));
+    ng->delta = malloc((n_nodes + 1) * sizeof(double));
+    ng->cand_slot = malloc((n_edges + 1) * sizeof(narrow_int_t));
+    ng->cand_capacity = 16;
+    ng->cand_sum = malloc(ng->cand_capacity * sizeof(double));
+    if (!rows || !cols || !eids || !ng->out_offsets || !ng->out_nbrs || !ng->out_eids || !ng->dist ||
+        !ng->queue || !ng->sigma || !ng->delta || !ng->cand_slot || !ng->cand_sum) {
+        fprintf(stderr, "Failed to allocate narrow graph\n");
+        exit(1);
+    }
+
+    for (narrow_int_t e = 0; e < ng->n_edges; e++) {
+        igraph_integer_t from, to;
+        igraph_edge(graph, e, &from, &to);
+        ng->cand_slot[e] = -1;
+        if (from == to) continue;
+        rows[n_entries] = (narrow_int_t)from;
+        cols[n_entries] = (narrow_int_t)to;
+        eids[n_entries++] = e;
+        if (!ng->directed) {
+            rows[n_entries] = (narrow_int_t)to;
+            cols[n_entries] = (narrow_int_t)from;
+            eids[n_entries++] = e;
+        }
+    }
+
+    fill_narrow_csr(ng->n_nodes, n_entries, rows, cols, eids, ng->out_offsets, ng->out_nbrs, ng->out_eids);
+    if (ng->directed) {
+        ng->in_offsets = malloc((n_nodes + 1) * sizeof(narrow_int_t));
+        ng->in_nbrs = malloc((n_edges + 1) * sizeof(narrow_int_t));
+        ng->in_eids = malloc((n_edges + 1) * sizeof(narrow_int_t));
+        if (!ng->in_offsets || !ng->in_nbrs || !ng->in_eids) {
+            fprintf(stderr, "Failed to allocate narrow graph\n");
+            exit(1);
+        }
+        fill_narrow_csr(ng->n_nodes, n_entries, cols, rows, eids, ng->in_offsets, ng->in_nbrs, ng->in_eids);
+    } else {
+        ng->in_offsets = ng->out_offsets;
+        ng->in_nbrs = ng->out_nbrs;
+        ng->in_eids = ng->out_eids;
+    }
+
+    free(rows);
+    free(cols);
+    free(eids);
+}
+
+// Remove edge eid from one adjacency and shift later edge IDs down, as igraph_delete_edges() does
+void narrow_csr_delete_edge(narrow_int_t n_nodes, narrow_int_t *offsets, narrow_int_t *nbrs, narrow_int_t *eids,
+                            narrow_int_t eid) {
+    narrow_int_t out = 0;
+    narrow_int_t start = 0;
+
+    for (narrow_int_t v = 0; v < n_nodes; v++) {
+        narrow_int_t end = offsets[v + 1];
+        for (narrow_int_t k = start; k < end; k++) {
+            if (eids[k] == eid) continue;
+            nbrs[out] = nbrs[k];
+            eids[out] = eids[k] > eid ? eids[k] - 1 : eids[k];
+            out++;
+        }
+        start = end;
+        offsets[v + 1] = out;
+    }
+}
+
+void narrow_graph_delete_edge(NarrowGraph *ng, narrow_int_t eid) {
+    narrow_csr_delete_edge(ng->n_nodes, ng->out_offsets, ng->out_nbrs, ng->out_eids, eid);
+    if (ng->directed) {
+        narrow_csr_delete_edge(ng->n_nodes, ng->in_offsets, ng->in_nbrs, ng->in_eids, eid);
+    }
+    ng->n_edges--;
+}
+
+void free_narrow_graph(NarrowGraph *ng) {
+    if (ng->directed) {
+        free(ng->in_offsets);
+        free(ng->in_nbrs);
+        free(ng->in_eids);
+    }
+    free(ng->out_offsets);
+    free(ng->out_nbrs);
+    free(ng->out_eids);
+    free(ng->dist);
+    free(ng->queue);
+    free(ng->sigma);
+    free(ng->delta);
+    free(ng->cand_slot);
+    free(ng->cand_sum);
+}
+
+// Edge betweenness of the candidate edges only, res[c] for candidates[c]. Follows the unweighted
+// igraph_edge_betweenness() step for step so the doubles are bit-identical to the 64-bit build:
+// BFS in incidence list order, then vertices w in reverse BFS order form
+// coeff = (1 + delta[w]) / sigma[w] once and add sigma[v] * coeff to each parent v and its edge.
+// All additions into one delta[v] from a given w are the same value, so only the reverse BFS order
+// of w matters, not the order of parents within it.
+void narrow_edge_betweenness(NarrowGraph *ng, const igraph_vector_int_t *candidates, igraph_vector_t *res) {
+    narrow_int_t n = ng->n_nodes;
+    narrow_int_t n_cand = (narrow_int_t)igraph_vector_int_size(candidates);
+    narrow_int_t *dist = ng->dist;
+    narrow_int_t *queue = ng->queue;
+    double *sigma = ng->sigma;
+    double *delta = ng->delta;
+
+    if (n_cand > ng->cand_capacity) {
+        ng->cand_capacity = n_cand;
+        ng->cand_sum = realloc(ng->cand_sum, ng->cand_capacity * sizeof(double));
+        if (!ng->cand_sum) {
+            fprintf(stderr, "Failed to allocate narrow betweenness buffers\n");
+            exit(1);
+        }
+    }
+    for (narrow_int_t c = 0; c < n_cand; c++) {
+        ng->cand_slot[VECTOR(*candidates)[c]] = c;
+        ng->cand_sum[c] = 0.0;
+    }
+
+    for (narrow_int_t s = 0; s < n; s++) {
+        for (narrow_int_t v = 0; v < n; v++) {
+            dist[v] = -1;
+            sigma[v] = 0.0;
+            delta[v] = 0.0;
+        }
+
+        // Forward BFS counting shortest paths
+        narrow_int_t head = 0, tail = 0;
+        dist[s] = 0;
+        sigma[s] = 1.0;
+        queue[tail++] = s;
+        while (head < tail) {
+            narrow_int_t v = queue[head++];
+            for (narrow_int_t k = ng->out_offsets[v]; k < ng->out_offsets[v + 1]; k++) {
+                narrow_int_t w = ng->out_nbrs[k];
+                if (dist[w] < 0) {
+                    dist[w] = dist[v] + 1;
+                    queue[tail++] = w;
+                }
+                if (dist[w] == dist[v] + 1) {
+                    sigma[w] += sigma[v];
+                }
+            }
+        }
+
+        // Backward pass: push each vertex's dependency to its parents
+        for (narrow_int_t idx = tail - 1; idx > 0; idx--) {
+            narrow_int_t w = queue[idx];
+            double coeff = (1 + delta[w]) / sigma[w];
+            for (narrow_int_t k = ng->in_offsets[w]; k < ng->in_offsets[w + 1]; k++) {
+                narrow_int_t v = ng->in_nbrs[k];
+                if (dist[v] < 0 || dist[v] + 1 != dist[w]) continue;
+
+                delta[v] += sigma[v] * coeff;
+                narrow_int_t slot = ng->cand_slot[ng->in_eids[k]];
+                if (slot >= 0) {
+                    ng->cand_sum[slot] += sigma[v] * coeff;
+                }
+            }
+        }
+    }
+
+    // Undirected pairs are counted from both ends
+    double scale = ng->directed ? 1.0 : 0.5;
+    igraph_vector_resize(res, n_cand);
+    for (narrow_int_t c = 0; c < n_cand; c++) {
+        VECTOR(*res)[c] = ng->cand_sum[ng->cand_slot[VECTOR(*candidates)[c]]] * scale;
+    }
+    for (narrow_int_t c = 0; c < n_cand; c++) {
+        ng->cand_slot[VECTOR(*candidates)[c]] = -1;
+    }
+}
+
+// Same rule as the selector subgraph: maximum betweenness, then lowest "order", applied to the
+// candidate edges directly. Returns the edge ID in graph, -1 if there are no candidates.
+igraph_integer_t select_max_betweenness_candidate(const igraph_t *graph, const igraph_vector_int_t *candidates,
+                                                  const igraph_vector_t *btwn) {
+    igraph_real_t max_btwn = -1.0;
+    igraph_real_t min_order = 0.0;
+    igraph_integer_t max_btwn_edge = -1;
+
+    for (igraph_integer_t c = 0; c < igraph_vector_int_size(candidates); c++) {
+        igraph_integer_t eid = VECTOR(*candidates)[c];
+        igraph_real_t btwn_value = VECTOR(*btwn)[c];
+        igraph_real_t order_value = igraph_cattribute_EAN(graph, "order", eid);
+
+        if (btwn_value > max_btwn) {
+            max_btwn = btwn_value;
+            max_btwn_edge = eid;
+            min_order = order_value;
+        } else if (btwn_value == max_btwn && order_value < min_order) {
+            max_btwn_edge = eid;
+            min_order = order_value;
+        }
+    }
+
+    return max_btwn_edge;
+}
+#endif
+
 // node degree+edge betweenness community detection function, accesses original node names
 void cluster_degree_betweenness(igraph_t *graph, NameIndexMap *city_map, Result *res, bool directed) {
-    igraph_t graph_, subgraph_;
+    igraph_t graph_;
     igraph_vector_ptr_t cmpnts;
     igraph_vector_t *modularities = malloc(sizeof(igraph_vector_t));
     igraph_integer_t n_edges, n_nodes, i;
@@ -318,12 +620,16 @@ void cluster_degree_betweenness(igraph_t *graph, NameIndexMap *city_map, Result
         fprintf(stderr, "Failed to copy graph\n");
         exit(1);
     }
+#ifdef NARROW_TYPES
+    NarrowGraph ng;
+    igraph_vector_t cand_btwn;
+    init_narrow_graph(&graph_, &ng, directed);
+    igraph_vector_init(&cand_btwn, 0);
+#endif
 
     for (i = 0; i < n_edges; i++) {
         igraph_vector_int_t degrees, order, edge_ids, vertex_ids;
         igraph_vector_int_init(&degrees, n_nodes);
-        igraph_real_t max_btwn;
-        igraph_integer_t max_btwn_edge;
         igraph_degree(&graph_, &degrees, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS);
 
         // Print iteration start, and node degrees
@@ -361,6 +667,41 @@ void cluster_degree_betweenness(igraph_t *graph, NameIndexMap *city_map, Result
         // Print the vertex IDs
         //print_vector_int(&vertex_ids, "Selector subgraph vertex IDs");
 
+#ifdef NARROW_TYPES
+        // Betweenness of the incident edges only, selection reads them without the selector subgraph
+        narrow_edge_betweenness(&ng, &edge_ids, &cand_btwn);
+        igraph_integer_t max_btwn_edge = select_max_betweenness_candidate(&graph_, &edge_ids, &cand_btwn);
+        const char *edge_name = igraph_cattribute_EAS(&graph_, "name", max_btwn_edge);
+
+        // Check the narrow pick against igraph's 64-bit betweenness before the edge is removed
+        if (verify) {
+            igraph_vector_t ref_btwn, ref_cand_btwn;
+            igraph_vector_init(&ref_btwn, igraph_ecount(&graph_));
+            igraph_vector_init(&ref_cand_btwn, igraph_vector_int_size(&edge_ids));
+            igraph_edge_betweenness(&graph_, &ref_btwn, directed, NULL);
+            for (igraph_integer_t c = 0; c < igraph_vector_int_size(&edge_ids); c++) {
+                VECTOR(ref_cand_btwn)[c] = VECTOR(ref_btwn)[VECTOR(edge_ids)[c]];
+            }
+            igraph_integer_t ref_edge = select_max_betweenness_candidate(&graph_, &edge_ids, &ref_cand_btwn);
+            if (ref_edge != max_btwn_edge) {
+                fprintf(stderr, "Verify mismatch at iteration %ld: narrow %s, 64-bit %s\n", (long)(i + 1),
+                        edge_name, igraph_cattribute_EAS(&graph_, "name", ref_edge));
+                exit(EXIT_FAILURE);
+            }
+            igraph_vector_destroy(&ref_btwn);
+            igraph_vector_destroy(&ref_cand_btwn);
+        }
+
+        // Remove edge with highest edge betweenness from &graph_ and the narrow adjacency
+        igraph_integer_t removed_eid = delete_edge_by_name(&graph_, edge_name);
+        if (removed_eid >= 0) {
+            narrow_graph_delete_edge(&ng, (narrow_int_t)removed_eid);
+        }
+#else
+        igraph_t subgraph_;
+        igraph_real_t max_btwn;
+        igraph_integer_t max_btwn_edge;
+
         // Calculate edge-betweeness in graph, need to set this as edge attribute 
         igraph_vector_t edge_btwn;
         igraph_vector_init(&edge_btwn, igraph_ecount(&graph_));
@@ -368,6 +709,7 @@ void cluster_degree_betweenness(igraph_t *graph, NameIndexMap *city_map, Result
 
         // Assign betweenness as an edge attribute
         igraph_cattribute_EAN_setv(&graph_, "betweenness", &edge_btwn);
+        igraph_vector_destroy(&edge_btwn);
 
 
         // Assign which edges to keep based on &edge_ids
@@ -473,6 +815,7 @@ void cluster_degree_betweenness(igraph_t *graph, NameIndexMap *city_map, Result
         // Remove edge with highest edge betweenness in &subgraph_ from &graph_
         // Delete edge by name, using created void function since igraph C library does not have this function
         delete_edge_by_name(&graph_, edge_name);
+#endif
 
         // Print edges with names from &graph_
         /*printf("Subgraph edges:\n");
@@ -498,6 +841,11 @@ void cluster_degree_betweenness(igraph_t *graph, NameIndexMap *city_map, Result
         igraph_vector_int_destroy(&edge_ids);
     }
 
+#ifdef NARROW_TYPES
+    free_narrow_graph(&ng);
+    igraph_vector_destroy(&cand_btwn);
+#endif
+
     // Restore original graph
     igraph_destroy(&graph_);
     igraph_copy(&graph_, graph);
@@ -613,7 +961,7 @@ int main(int argc, char *argv[]) {
     igraph_set_attribute_table(&igraph_cattribute_table);
 
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s [-directed] <filename>\n", argv[0]);
+        fprintf(stderr, "Usage: %s [-directed] [-verify] <filename>\n", argv[0]);
         return EXIT_FAILURE;
     }
 
@@ -622,6 +970,8 @@ int main(int argc, char *argv[]) {
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-directed") == 0) {
             directed = true;
+        } else if (strcmp(argv[i], "-verify") == 0) {
+            verify = true;
         } else {
             filename = argv[i];
         }
@@ -630,6 +980,12 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Error: No input file provided.\n");
         return EXIT_FAILURE;
     }
+#ifndef NARROW_TYPES
+    if (verify) {
+        fprintf(stderr, "Error: -verify is only available in the narrow build (make narrow).\n");
+        return EXIT_FAILURE;
+    }
+#endif
 
     // 2) Read graph
     igraph_t g;
@@ -666,5 +1022,11 @@ int main(int argc, char *argv[]) {
     igraph_vector_int_destroy(res.membership); free(res.membership);
     free_name_index_map(&city_map);
 
+#ifdef NARROW_TYPES
+    if (verify) {
+        printf("Verify: narrow build selected the same edge as the 64-bit build at every iteration\n");
+    }
+#endif
+
     return EXIT_SUCCESS;
 }